@@ -0,0 +1,527 @@
+#ifndef _WIN32
+#define _DEFAULT_SOURCE  // shm_open, ftruncate, fsync, flock
+#endif
+
+#include "betweenness_mp.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+
+double* calculateBetweennessCentralityMultiProcess(Graph* graph, int numWorkers, int chunkSize,
+    const char* checkpointDir) {
+    printf("Multi-process betweenness requires POSIX shared memory and fork (Linux only).\n");
+    return NULL;
+}
+
+#else
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+#define CHECKPOINT_MAGIC 0x42434B50u  // "PKCB"
+#define MERGED_MAGIC 0x424D4B50u      // "PKMB"
+#define MAX_ROUNDS 3                  // Times the remaining ranges are retried after worker failures
+#define RANGES_PER_WORKER 8           // Ranges handed out per worker each round, bounding the unmerged range files
+
+// Start of the shared memory region. It is followed by
+// int edgeOffsets[numVertices + 1], int neighbors[numEdges] and int pendingRanges[numRanges]
+typedef struct SharedGraphHeader {
+    atomic_int nextRange;  // Index of the next unclaimed entry in pendingRanges
+    int numPending;        // Number of valid entries in pendingRanges
+    int numVertices;
+    int numEdges;
+    int chunkSize;         // Source vertices per range
+} SharedGraphHeader;
+
+typedef struct SharedGraph {
+    SharedGraphHeader* header;
+    int* edgeOffsets;
+    int* neighbors;
+    int* pendingRanges;
+    size_t size;
+} SharedGraph;
+
+// Start of a checkpoint file (range_<range>.bin). It is followed by the range's own
+// contribution, double partial[numVertices]
+typedef struct CheckpointHeader {
+    unsigned int magic;
+    unsigned int graphHash;  // Guards against merging checkpoints from a different graph
+    int numVertices;
+    int chunkSize;
+    int range;               // Source range this checkpoint covers
+} CheckpointHeader;
+
+// Start of the merged checkpoint (merged.bin) that folds in every finished range. It is followed by
+// unsigned char doneBits[(numRanges + 7) / 8] and the summed scores, double betweenness[numVertices]
+typedef struct MergedHeader {
+    unsigned int magic;
+    unsigned int graphHash;
+    int numVertices;
+    int chunkSize;
+    int numRanges;
+} MergedHeader;
+
+// FNV-1a over the frozen adjacency, in adjacency-list order
+static unsigned int hashSharedGraph(const SharedGraph* shared) {
+    unsigned int hash = 2166136261u;
+    int numValues = shared->header->numVertices + 1 + shared->header->numEdges;
+    for (int i = 0; i < numValues; i++) {
+        hash = (hash ^ (unsigned int)shared->edgeOffsets[i]) * 16777619u;  // neighbors follows edgeOffsets
+    }
+    return hash;
+}
+
+// Copy the graph's compressed edge arrays into an anonymous POSIX shared memory object. The name is unlinked
+// straight away, so the mapping disappears with the last process even if the driver crashes
+static bool createSharedGraph(Graph* graph, int numRanges, int chunkSize, SharedGraph* shared) {
+    if (!ensureEdgeArrays(graph)) {
+        return false;
+    }
+    int numEdges = graph->edgeOffsets[graph->numVertices];
+
+    shared->size = sizeof(SharedGraphHeader)
+        + (size_t)(graph->numVertices + 1 + numEdges + numRanges) * sizeof(int);
+
+    char name[64];
+    snprintf(name, sizeof(name), "/kit205_betweenness_%d", (int)getpid());
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        perror("shm_open");
+        return false;
+    }
+    shm_unlink(name);
+
+    if (ftruncate(fd, (off_t)shared->size) != 0) {
+        perror("ftruncate");
+        close(fd);
+        return false;
+    }
+    void* base = mmap(NULL, shared->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+
+    shared->header = base;
+    shared->edgeOffsets = (int*)(shared->header + 1);
+    shared->neighbors = shared->edgeOffsets + graph->numVertices + 1;
+    shared->pendingRanges = shared->neighbors + numEdges;
+
+    atomic_init(&shared->header->nextRange, 0);
+    shared->header->numPending = 0;
+    shared->header->numVertices = graph->numVertices;
+    shared->header->numEdges = numEdges;
+    shared->header->chunkSize = chunkSize;
+
+    memcpy(shared->edgeOffsets, graph->edgeOffsets, (graph->numVertices + 1) * sizeof(int));
+    memcpy(shared->neighbors, graph->neighbors, numEdges * sizeof(int));
+
+    return true;
+}
+
+// Write the blocks to a temporary file and rename it into place, so a crash mid-write
+// never leaves a partial checkpoint behind
+static bool writeFileAtomically(const char* path, const void* const* blocks, const size_t* sizes, int numBlocks) {
+    char tmpPath[4096 + 32];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.%d.tmp", path, (int)getpid());
+
+    FILE* file = fopen(tmpPath, "wb");
+    if (!file) {
+        perror("fopen");
+        return false;
+    }
+
+    bool written = true;
+    for (int i = 0; written && i < numBlocks; i++) {
+        written = sizes[i] == 0 || fwrite(blocks[i], sizes[i], 1, file) == 1;
+    }
+    written = written && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    fclose(file);
+
+    if (!written || rename(tmpPath, path) != 0) {
+        printf("Failed to write checkpoint %s.\n", path);
+        remove(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+// Leave a worker, flushing first so error messages survive when stdout is a pipe
+static void exitWorker(int status) {
+    fflush(stdout);
+    _exit(status);
+}
+
+// Worker process: claim ranges until none are left, checkpointing each one. Never returns
+static void runWorker(const SharedGraph* shared, unsigned int graphHash, const char* checkpointDir,
+    pid_t driverPid) {
+#ifdef __linux__
+    // Die with the driver, so orphans cannot keep claiming ranges after it crashes. Checking
+    // the parent afterwards covers a driver that died before the signal was armed
+    if (prctl(PR_SET_PDEATHSIG, SIGKILL) != 0 || getppid() != driverPid) {
+        exitWorker(1);
+    }
+#endif
+
+    // Sources are traversed straight from the shared edge arrays; nothing is copied per worker
+    SharedGraphHeader* header = shared->header;
+    double* partial = malloc((header->numVertices > 0 ? header->numVertices : 1) * sizeof(double));
+    if (!partial) {
+        printf("Memory allocation failed in betweenness worker %d.\n", (int)getpid());
+        exitWorker(1);
+    }
+
+    for (;;) {
+        int index = atomic_fetch_add(&header->nextRange, 1);
+        if (index >= header->numPending) {
+            break;
+        }
+
+        int range = shared->pendingRanges[index];
+        int first = range * header->chunkSize;
+        int last = first + header->chunkSize < header->numVertices ? first + header->chunkSize : header->numVertices;
+        for (int i = 0; i < header->numVertices; i++) {
+            partial[i] = 0.0;
+        }
+        for (int s = first; s < last; s++) {
+            if (!accumulateBetweennessFromEdgeArrays(header->numVertices, shared->edgeOffsets, shared->neighbors,
+                s, partial)) {
+                exitWorker(1);
+            }
+        }
+
+        // One file per range: recomputing a range overwrites it with the same scores
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/range_%d.bin", checkpointDir, range);
+        CheckpointHeader checkpoint = { CHECKPOINT_MAGIC, graphHash, header->numVertices, header->chunkSize, range };
+        const void* blocks[] = { &checkpoint, partial };
+        size_t sizes[] = { sizeof(checkpoint), header->numVertices * sizeof(double) };
+        if (!writeFileAtomically(path, blocks, sizes, 2)) {
+            exitWorker(1);
+        }
+    }
+
+    free(partial);
+    exitWorker(0);
+}
+
+// Read merged.bin, if there is one, into betweenness and rangeDone
+static bool loadMergedCheckpoint(const char* checkpointDir, unsigned int graphHash, int numVertices, int chunkSize,
+    int numRanges, bool* rangeDone, double* betweenness) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/merged.bin", checkpointDir);
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        if (errno == ENOENT) {
+            return true;  // Nothing merged yet
+        }
+        perror("fopen");
+        return false;
+    }
+
+    size_t numBitBytes = (size_t)(numRanges + 7) / 8;
+    unsigned char* doneBits = malloc(numBitBytes > 0 ? numBitBytes : 1);
+    if (!doneBits) {
+        printf("Memory allocation failed in loadMergedCheckpoint.\n");
+        fclose(file);
+        return false;
+    }
+
+    MergedHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1
+        && header.magic == MERGED_MAGIC && header.graphHash == graphHash
+        && header.numVertices == numVertices && header.chunkSize == chunkSize
+        && header.numRanges == numRanges
+        && fread(doneBits, 1, numBitBytes, file) == numBitBytes
+        && fread(betweenness, sizeof(double), numVertices, file) == (size_t)numVertices;
+    fclose(file);
+
+    if (valid) {
+        for (int r = 0; r < numRanges; r++) {
+            rangeDone[r] = (doneBits[r / 8] >> (r % 8)) & 1;
+        }
+    }
+    else {
+        printf("Checkpoint %s does not belong to this graph and chunk size, or is corrupt.\n", path);
+    }
+    free(doneBits);
+    return valid;
+}
+
+// Start from merged.bin and add every range checkpoint it does not cover yet, marking the ranges
+// done. numRangeFiles counts the range files found. Leftover .tmp files from killed workers are removed
+static bool loadCheckpoints(const char* checkpointDir, unsigned int graphHash, int numVertices, int chunkSize,
+    int numRanges, bool* rangeDone, double* betweenness, int* numRangeFiles) {
+    for (int r = 0; r < numRanges; r++) {
+        rangeDone[r] = false;
+    }
+    for (int i = 0; i < numVertices; i++) {
+        betweenness[i] = 0.0;
+    }
+    *numRangeFiles = 0;
+
+    if (!loadMergedCheckpoint(checkpointDir, graphHash, numVertices, chunkSize, numRanges, rangeDone, betweenness)) {
+        return false;
+    }
+
+    DIR* dir = opendir(checkpointDir);
+    if (!dir) {
+        perror("opendir");
+        return false;
+    }
+
+    double* partial = malloc(numVertices * sizeof(double));
+    if (!partial && numVertices > 0) {
+        printf("Memory allocation failed in loadCheckpoints.\n");
+        closedir(dir);
+        return false;
+    }
+
+    bool ok = true;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s", checkpointDir, entry->d_name);
+        size_t length = strlen(entry->d_name);
+        if (length >= 4 && strcmp(entry->d_name + length - 4, ".tmp") == 0) {
+            remove(path);
+            continue;
+        }
+        if (strncmp(entry->d_name, "range_", 6) != 0) {
+            continue;  // Not a range checkpoint (e.g. merged.bin or the lock file)
+        }
+
+        FILE* file = fopen(path, "rb");
+        if (!file) {
+            perror("fopen");
+            ok = false;
+            break;
+        }
+
+        CheckpointHeader header;
+        bool valid = fread(&header, sizeof(header), 1, file) == 1
+            && header.magic == CHECKPOINT_MAGIC && header.graphHash == graphHash
+            && header.numVertices == numVertices && header.chunkSize == chunkSize
+            && header.range >= 0 && header.range < numRanges
+            && fread(partial, sizeof(double), numVertices, file) == (size_t)numVertices;
+        fclose(file);
+
+        if (!valid) {
+            printf("Checkpoint %s does not belong to this graph and chunk size, or is corrupt.\n", path);
+            ok = false;
+            break;
+        }
+        (*numRangeFiles)++;
+        if (rangeDone[header.range]) {
+            continue;  // Already merged (the driver died before deleting it); its scores are counted
+        }
+
+        rangeDone[header.range] = true;
+        for (int i = 0; i < numVertices; i++) {
+            betweenness[i] += partial[i];
+        }
+    }
+
+    free(partial);
+    closedir(dir);
+    return ok;
+}
+
+// Write the loaded totals to merged.bin, then delete the range files it now covers. The rename
+// makes the merge atomic, and a range file that outlives it is skipped by the done bits on the next load
+static bool mergeCheckpoints(const char* checkpointDir, unsigned int graphHash, int numVertices, int chunkSize,
+    int numRanges, const bool* rangeDone, const double* betweenness) {
+    size_t numBitBytes = (size_t)(numRanges + 7) / 8;
+    unsigned char* doneBits = calloc(numBitBytes > 0 ? numBitBytes : 1, 1);
+    if (!doneBits) {
+        printf("Memory allocation failed in mergeCheckpoints.\n");
+        return false;
+    }
+    for (int r = 0; r < numRanges; r++) {
+        if (rangeDone[r]) {
+            doneBits[r / 8] |= (unsigned char)(1u << (r % 8));
+        }
+    }
+
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/merged.bin", checkpointDir);
+    MergedHeader header = { MERGED_MAGIC, graphHash, numVertices, chunkSize, numRanges };
+    const void* blocks[] = { &header, doneBits, betweenness };
+    size_t sizes[] = { sizeof(header), numBitBytes, numVertices * sizeof(double) };
+    bool written = writeFileAtomically(path, blocks, sizes, 3);
+    free(doneBits);
+    if (!written) {
+        return false;
+    }
+
+    // No worker is running between rounds, so every range file here was just merged
+    DIR* dir = opendir(checkpointDir);
+    if (!dir) {
+        perror("opendir");
+        return false;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "range_", 6) == 0) {
+            snprintf(path, sizeof(path), "%s/%s", checkpointDir, entry->d_name);
+            remove(path);
+        }
+    }
+    closedir(dir);
+    return true;
+}
+
+double* calculateBetweennessCentralityMultiProcess(Graph* graph, int numWorkers, int chunkSize,
+    const char* checkpointDir) {
+    if (graph == NULL || graph->adjLists == NULL) {
+        printf("Graph is NULL or uninitialized.\n");
+        return NULL;
+    }
+    if (numWorkers < 1 || chunkSize < 1 || checkpointDir == NULL) {
+        printf("Invalid worker count, chunk size or checkpoint directory.\n");
+        return NULL;
+    }
+
+    // Only one driver may use a checkpoint directory at a time. Workers inherit the lock, so it
+    // is held until the last process of this run has exited
+    char lockPath[4096];
+    snprintf(lockPath, sizeof(lockPath), "%s/driver.lock", checkpointDir);
+    int lockFd = open(lockPath, O_CREAT | O_RDWR, 0600);
+    if (lockFd < 0) {
+        perror("open");
+        return NULL;
+    }
+    if (flock(lockFd, LOCK_EX | LOCK_NB) != 0) {
+        if (errno == EWOULDBLOCK) {
+            printf("Checkpoint directory %s is in use by another driver.\n", checkpointDir);
+        }
+        else {
+            perror("flock");
+        }
+        close(lockFd);
+        return NULL;
+    }
+
+    int numRanges = (graph->numVertices + chunkSize - 1) / chunkSize;
+    SharedGraph shared;
+    if (!createSharedGraph(graph, numRanges, chunkSize, &shared)) {
+        close(lockFd);
+        return NULL;
+    }
+    unsigned int graphHash = hashSharedGraph(&shared);
+
+    double* betweenness = malloc(graph->numVertices * sizeof(double));
+    bool* rangeDone = malloc(numRanges * sizeof(bool));
+    pid_t* pids = malloc(numWorkers * sizeof(pid_t));
+    if ((!betweenness && graph->numVertices > 0) || (!rangeDone && numRanges > 0) || !pids) {
+        printf("Memory allocation failed in calculateBetweennessCentralityMultiProcess.\n");
+        free(betweenness);
+        free(rangeDone);
+        free(pids);
+        munmap(shared.header, shared.size);
+        close(lockFd);
+        return NULL;
+    }
+
+    bool complete = false;
+    int numFailedRounds = 0;
+    for (;;) {
+        // Anything already checkpointed (by this call or an earlier one) is not recomputed. Ranges
+        // finished since the last merge are folded into merged.bin, so at most one round's range
+        // files are on disk at a time
+        int numRangeFiles = 0;
+        if (!loadCheckpoints(checkpointDir, graphHash, graph->numVertices, chunkSize, numRanges,
+            rangeDone, betweenness, &numRangeFiles)) {
+            break;
+        }
+        if (numRangeFiles > 0 && !mergeCheckpoints(checkpointDir, graphHash, graph->numVertices, chunkSize,
+            numRanges, rangeDone, betweenness)) {
+            break;
+        }
+
+        int numPending = 0;
+        for (int r = 0; r < numRanges; r++) {
+            if (!rangeDone[r]) {
+                shared.pendingRanges[numPending++] = r;
+            }
+        }
+        if (numPending == 0) {
+            complete = true;
+            break;
+        }
+        if (numFailedRounds > MAX_ROUNDS) {
+            printf("%d source ranges still missing after %d retries.\n", numPending, MAX_ROUNDS);
+            break;
+        }
+
+        // Each round takes a bounded batch of the pending ranges, so it is merged before the next batch starts
+        if ((long long)numPending > (long long)numWorkers * RANGES_PER_WORKER) {
+            numPending = numWorkers * RANGES_PER_WORKER;
+        }
+
+        shared.header->numPending = numPending;
+        atomic_store(&shared.header->nextRange, 0);
+
+        // Flush so buffered output is not duplicated into every child
+        fflush(stdout);
+        pid_t driverPid = getpid();
+        int numForked = 0;
+        int numToFork = numWorkers < numPending ? numWorkers : numPending;
+        for (int w = 0; w < numToFork; w++) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                runWorker(&shared, graphHash, checkpointDir, driverPid);
+            }
+            if (pid < 0) {
+                perror("fork");
+                break;
+            }
+            pids[numForked++] = pid;
+        }
+
+        // A worker that dies loses only the range it was working on; the next round picks it up
+        bool failed = numForked < numToFork;
+        for (int w = 0; w < numForked; w++) {
+            int status;
+            if (waitpid(pids[w], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                printf("Betweenness worker %d failed; its unfinished range will be re-run.\n", (int)pids[w]);
+                failed = true;
+            }
+        }
+        numFailedRounds += failed;
+    }
+
+    free(rangeDone);
+    free(pids);
+    munmap(shared.header, shared.size);
+    close(lockFd);
+
+    if (!complete) {
+        free(betweenness);
+        return NULL;
+    }
+
+    // Normalize betweenness centrality for undirected graph, as calculateBetweennessCentrality does
+    for (int i = 0; i < graph->numVertices; i++) {
+        betweenness[i] /= 2.0;
+    }
+
+    return betweenness;
+}
+
+#endif
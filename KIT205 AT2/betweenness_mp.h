@@ -0,0 +1,21 @@
+#pragma once
+#ifndef BETWEENNESS_MP_H
+#define BETWEENNESS_MP_H
+
+#include "graph.h"
+
+// Multi-process betweenness centrality (Linux only).
+// The graph is frozen into POSIX shared memory and numWorkers forked processes claim ranges of
+// chunkSize source vertices from a shared counter and traverse the shared edge arrays directly.
+// Each finished range is checkpointed to its own file in checkpointDir (which must already exist),
+// and after every round the driver folds those files into a single merged checkpoint (summed
+// scores plus a done-range bitmap) and deletes them, so disk use stays around numVertices doubles
+// per range of one round plus the merged file. Ranges lost to a crashed worker are re-run, workers
+// are killed if the driver dies, and calling again with the same checkpointDir resumes from the
+// existing checkpoints. A lock file keeps a second driver out of a directory that is in use.
+// The result matches calculateBetweennessCentrality up to floating-point summation order.
+// Returns NULL on failure (including checkpoints from another graph or chunk size), and always on Windows.
+double* calculateBetweennessCentralityMultiProcess(Graph* graph, int numWorkers, int chunkSize,
+    const char* checkpointDir);
+
+#endif
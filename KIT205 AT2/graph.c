@@ -44,6 +44,16 @@ void freeQueue(Queue* q) {
     }
 }
 
+// Drop the compressed edge view; it no longer matches the adjacency lists once they change
+static void releaseEdgeArrays(Graph* graph) {
+    free(graph->edgeOffsets);
+    free(graph->neighbors);
+    free(graph->edgeWeights);
+    graph->edgeOffsets = NULL;
+    graph->neighbors = NULL;
+    graph->edgeWeights = NULL;
+}
+
 
 Graph* createGraph(int vertices) {
     Graph* graph = malloc(sizeof(Graph));
@@ -54,6 +64,10 @@ Graph* createGraph(int vertices) {
     printf("Graph allocated at %p\n", (void*)graph);
 
     graph->numVertices = vertices;
+    graph->edgeOffsets = NULL;
+    graph->neighbors = NULL;
+    graph->edgeWeights = NULL;
+    graph->structureVersion = 0;
     graph->adjLists = malloc(vertices * sizeof(Node*));
     if (!graph->adjLists) {
         printf("Memory allocation failed for adjLists.\n");
@@ -70,6 +84,9 @@ Graph* createGraph(int vertices) {
 }
 
 void addEdge(Graph* graph, int src, int dest) {
+    releaseEdgeArrays(graph);
+    graph->structureVersion++;
+
     Node* newNode = malloc(sizeof(Node));
     newNode->vertex = dest;
     newNode->next = graph->adjLists[src];
@@ -98,144 +115,163 @@ int* calculateDegreeCentrality(Graph* graph) {
     return degree;
 }
 
-// Calculate betweenness centrality using Brandes' algorithm
-double* calculateBetweennessCentrality(Graph* graph) {
-    if (graph == NULL || graph->adjLists == NULL) {
-        printf("Graph is NULL or uninitialized.\n");
-        return NULL;
+// Add the dependencies of every vertex on source s to betweenness (one iteration of Brandes' algorithm).
+// The neighbors array lists each adjacency list in order, so the BFS visits vertices exactly as a walk
+// of the lists would
+bool accumulateBetweennessFromEdgeArrays(int numVertices, const int* edgeOffsets, const int* neighbors,
+    int s, double* betweenness) {
+    // Initialize data structures
+    int* sigma = malloc(numVertices * sizeof(int));    // Shortest paths count
+    int* dist = malloc(numVertices * sizeof(int));     // Distance from source
+    double* delta = malloc(numVertices * sizeof(double));  // Dependency score
+    int** pred = malloc(numVertices * sizeof(int*));   // Predecessor list
+    Queue* q = createQueue(numVertices);
+
+    // Memory allocation checks
+    if (sigma == NULL || dist == NULL || delta == NULL || pred == NULL || q == NULL) {
+        printf("Memory allocation failed in accumulateBetweennessFromEdgeArrays.\n");
+        free(sigma); free(dist); free(delta);
+        if (pred != NULL) { free(pred); }
+        if (q != NULL) { free(q->items); free(q); }
+        return false;
     }
 
-    double* betweenness = malloc(graph->numVertices * sizeof(double));
-    if (betweenness == NULL) {
-        printf("Memory allocation failed for betweenness.\n");
-        return NULL;
-    }
+    for (int i = 0; i < numVertices; i++) {
+        sigma[i] = 0;
+        dist[i] = -1;
+        delta[i] = 0.0;
+        pred[i] = malloc(numVertices * sizeof(int));
+        if (pred[i] == NULL) {  // Check memory allocation for pred[i]
+            printf("Memory allocation failed for pred[%d].\n", i);
+            // Free allocated memory before returning
+            free(sigma); free(dist); free(delta);
+            for (int j = 0; j < i; j++) {
+                free(pred[j]);
+            }
+            free(pred);
+            free(q->items); free(q);
+            return false;
+        }
 
-    // Initialize betweenness values to 0
-    for (int i = 0; i < graph->numVertices; i++) {
-        betweenness[i] = 0.0;
+        // Initialize pred[i] to -1 to mark no predecessors
+        for (int j = 0; j < numVertices; j++) {
+            pred[i][j] = -1;  // Initialize to invalid values (-1)
+        }
     }
 
-    // Loop over each node as the source
-    for (int s = 0; s < graph->numVertices; s++) {
-        // Initialize data structures
-        int* sigma = malloc(graph->numVertices * sizeof(int));    // Shortest paths count
-        int* dist = malloc(graph->numVertices * sizeof(int));     // Distance from source
-        double* delta = malloc(graph->numVertices * sizeof(double));  // Dependency score
-        int** pred = malloc(graph->numVertices * sizeof(int*));   // Predecessor list
-        Queue* q = createQueue(graph->numVertices);
-
-        // Memory allocation checks
-        if (sigma == NULL || dist == NULL || delta == NULL || pred == NULL || q == NULL) {
-            printf("Memory allocation failed in calculateBetweennessCentrality.\n");
-            free(sigma); free(dist); free(delta);
-            if (pred != NULL) { free(pred); }
-            if (q != NULL) { free(q->items); free(q); }
-            return NULL;
-        }
+    sigma[s] = 1;  // Only one shortest path to itself
+    dist[s] = 0;
 
-        for (int i = 0; i < graph->numVertices; i++) {
-            sigma[i] = 0;
-            dist[i] = -1;
-            delta[i] = 0.0;
-            pred[i] = malloc(graph->numVertices * sizeof(int));
-            if (pred[i] == NULL) {  // Check memory allocation for pred[i]
-                printf("Memory allocation failed for pred[%d].\n", i);
-                // Free allocated memory before returning
-                free(sigma); free(dist); free(delta);
-                for (int j = 0; j < i; j++) {
-                    free(pred[j]);
-                }
-                free(pred);
-                free(q->items); free(q);
-                return NULL;
-            }
+    // BFS from source node s
+    enqueue(q, s);
+    while (!isEmpty(q)) {
+        int v = dequeue(q);
 
-            // Initialize pred[i] to -1 to mark no predecessors
-            for (int j = 0; j < graph->numVertices; j++) {
-                pred[i][j] = -1;  // Initialize to invalid values (-1)
+        // Traverse neighbors
+        for (int e = edgeOffsets[v]; e < edgeOffsets[v + 1]; e++) {
+            int w = neighbors[e];
+            if (dist[w] < 0) {  // w is not visited
+                enqueue(q, w);
+                dist[w] = dist[v] + 1;
+            }
+            if (dist[w] == dist[v] + 1) {
+                sigma[w] += sigma[v];  // Count shortest paths
+                pred[w][sigma[w] - 1] = v;  // Add v as predecessor of w
             }
         }
+    }
 
-        sigma[s] = 1;  // Only one shortest path to itself
-        dist[s] = 0;
+    // Backpropagate dependencies
+    while (q->front > 0) {  // Ensure the queue has elements before accessing it
+        int w = q->items[--q->front];  // Backtracking in reverse BFS order
 
-        // BFS from source node s
-        enqueue(q, s);
-        while (!isEmpty(q)) {
-            int v = dequeue(q);
-            Node* adj = graph->adjLists[v];
+        // Validate that 'w' is within valid bounds
+        if (w < 0 || w >= numVertices) {
+            printf("Invalid index w: %d\n", w);
+            continue;  // Skip this iteration if the index is invalid
+        }
 
-            // Traverse neighbors
-            while (adj) {
-                int w = adj->vertex;
-                if (dist[w] < 0) {  // w is not visited
-                    enqueue(q, w);
-                    dist[w] = dist[v] + 1;
-                }
-                if (dist[w] == dist[v] + 1) {
-                    sigma[w] += sigma[v];  // Count shortest paths
-                    pred[w][sigma[w] - 1] = v;  // Add v as predecessor of w
-                }
-                adj = adj->next;
-            }
+        // Check if sigma[w] is zero, which would indicate no shortest paths
+        if (sigma[w] == 0) {
+            printf("No shortest paths found for w = %d\n", w);
+            continue;  // Skip this iteration if there are no shortest paths
         }
 
-        // Backpropagate dependencies
-        while (q->front > 0) {  // Ensure the queue has elements before accessing it
-            int w = q->items[--q->front];  // Backtracking in reverse BFS order
+        // Iterate over the predecessors
+        for (int i = 0; i < sigma[w]; i++) {
+            int v = pred[w][i];
 
-            // Validate that 'w' is within valid bounds
-            if (w < 0 || w >= graph->numVertices) {
-                printf("Invalid index w: %d\n", w);
+            // Skip invalid predecessor values (-1)
+            if (v == -1) {
+                continue;  // Skip uninitialized or invalid predecessors
+            }
+
+            // Validate that 'v' is within valid bounds
+            if (v < 0 || v >= numVertices) {
+                printf("Invalid index v: %d\n", v);
                 continue;  // Skip this iteration if the index is invalid
             }
 
-            // Check if sigma[w] is zero, which would indicate no shortest paths
-            if (sigma[w] == 0) {
-                printf("No shortest paths found for w = %d\n", w);
-                continue;  // Skip this iteration if there are no shortest paths
+            // Ensure sigma[w] is valid before performing the division
+            if (sigma[w] > 0) {
+                delta[v] += (sigma[v] / (double)sigma[w]) * (1 + delta[w]);
             }
+            else {
+                printf("Warning: Division by zero avoided at w = %d\n", w);
+            }
+        }
 
-            // Iterate over the predecessors
-            for (int i = 0; i < sigma[w]; i++) {
-                int v = pred[w][i];
+        if (w != s) {
+            betweenness[w] += delta[w];
+        }
+    }
 
-                // Skip invalid predecessor values (-1)
-                if (v == -1) {
-                    continue;  // Skip uninitialized or invalid predecessors
-                }
+    // Clean up
+    free(sigma);
+    free(dist);
+    free(delta);
+    for (int i = 0; i < numVertices; i++) {
+        free(pred[i]);
+    }
+    free(pred);
+    free(q->items);
+    free(q);
 
-                // Validate that 'v' is within valid bounds
-                if (v < 0 || v >= graph->numVertices) {
-                    printf("Invalid index v: %d\n", v);
-                    continue;  // Skip this iteration if the index is invalid
-                }
+    return true;
+}
 
-                // Ensure sigma[w] is valid before performing the division
-                if (sigma[w] > 0) {
-                    delta[v] += (sigma[v] / (double)sigma[w]) * (1 + delta[w]);
-                }
-                else {
-                    printf("Warning: Division by zero avoided at w = %d\n", w);
-                }
-            }
+bool accumulateBetweennessFromSource(Graph* graph, int s, double* betweenness) {
+    if (!ensureEdgeArrays(graph)) {
+        return false;
+    }
+    return accumulateBetweennessFromEdgeArrays(graph->numVertices, graph->edgeOffsets, graph->neighbors,
+        s, betweenness);
+}
 
-            if (w != s) {
-                betweenness[w] += delta[w];
-            }
-        }
+// Calculate betweenness centrality using Brandes' algorithm
+double* calculateBetweennessCentrality(Graph* graph) {
+    if (graph == NULL || graph->adjLists == NULL) {
+        printf("Graph is NULL or uninitialized.\n");
+        return NULL;
+    }
+
+    double* betweenness = malloc(graph->numVertices * sizeof(double));
+    if (betweenness == NULL) {
+        printf("Memory allocation failed for betweenness.\n");
+        return NULL;
+    }
 
-        // Clean up
-        free(sigma);
-        free(dist);
-        free(delta);
-        for (int i = 0; i < graph->numVertices; i++) {
-            free(pred[i]);
+    // Initialize betweenness values to 0
+    for (int i = 0; i < graph->numVertices; i++) {
+        betweenness[i] = 0.0;
+    }
+
+    // Loop over each node as the source
+    for (int s = 0; s < graph->numVertices; s++) {
+        if (!accumulateBetweennessFromSource(graph, s, betweenness)) {
+            free(betweenness);
+            return NULL;
         }
-        free(pred);
-        free(q->items);
-        free(q);
     }
 
     // Normalize betweenness centrality for undirected graph
@@ -284,37 +320,626 @@ int* selectCriticalNodes(Graph* graph, int k) {
     return selectedNodes;
 }
 
-// Simulate the spread of misinformation using the Independent Cascade Model (ICM)
+// Simulate the spread of misinformation using the Independent Cascade Model (ICM).
+// Only the initially influenced vertices get to spread (a single step of the traced cascade)
 int propagateMisinformation(Graph* graph, int* influenced, int numInfluenced, double probability) {
+    return propagateMisinformationTraced(graph, influenced, numInfluenced, probability, 1, NULL, NULL, NULL);
+}
+
+
+CascadeTrace* createCascadeTrace(Graph* graph) {
+    CascadeTrace* trace = malloc(sizeof(CascadeTrace));
+    if (!trace) {
+        printf("Memory allocation failed for cascade trace.\n");
+        return NULL;
+    }
+
+    // A vertex is activated at most once, so numVertices bounds both the events and the steps
+    trace->events = malloc(graph->numVertices * sizeof(CascadeEvent));
+    trace->frontierSizes = malloc(graph->numVertices * sizeof(int));
+    if (!trace->events || !trace->frontierSizes) {
+        printf("Memory allocation failed for cascade trace buffers.\n");
+        free(trace->events);
+        free(trace->frontierSizes);
+        free(trace);
+        return NULL;
+    }
+    trace->capacity = graph->numVertices;
+    trace->count = 0;
+    trace->numSteps = 0;
+
+    return trace;
+}
+
+// Record an activation in the trace (if any) and hand it to the consumer (if any)
+static void emitCascadeEvent(CascadeTrace* trace, CascadeCallback callback, void* userData,
+    int node, int parent, int step) {
+    CascadeEvent event = { node, parent, step };
+
+    if (trace && trace->count < trace->capacity) {
+        trace->events[trace->count++] = event;
+    }
+    if (callback) {
+        callback(&event, userData);
+    }
+}
+
+// Run the Independent Cascade Model step by step for up to maxSteps steps (maxSteps <= 0: until no
+// new vertices are activated). Every activation is reported with its parent and step so spread speed
+// and carrying edges can be analysed
+int propagateMisinformationTraced(Graph* graph, int* influenced, int numInfluenced, double probability,
+    int maxSteps, CascadeTrace* trace, CascadeCallback callback, void* userData) {
+    if (trace && trace->capacity < graph->numVertices) {
+        printf("Cascade trace capacity %d is smaller than the graph (%d vertices).\n",
+            trace->capacity, graph->numVertices);
+        return -1;
+    }
+
     int* status = calloc(graph->numVertices, sizeof(int));
-    int totalInfluenced = numInfluenced;
+    Queue* frontier = createQueue(graph->numVertices);
+    if (!status || !frontier) {
+        printf("Memory allocation failed in propagateMisinformationTraced.\n");
+        free(status);
+        freeQueue(frontier);
+        return -1;
+    }
 
-    for (int i = 0; i < numInfluenced; i++) {
-        status[influenced[i]] = 1;
+    if (trace) {
+        trace->count = 0;
+        trace->numSteps = 0;
     }
 
+    // Step 0: the seeds themselves
     for (int i = 0; i < numInfluenced; i++) {
-        int currentNode = influenced[i];
-        Node* neighbor = graph->adjLists[currentNode];
-
-        while (neighbor) {
-            int neighborNode = neighbor->vertex;
+        int seed = influenced[i];
+        if (status[seed] == 0) {
+            status[seed] = 1;
+            enqueue(frontier, seed);
+            emitCascadeEvent(trace, callback, userData, seed, -1, 0);
+        }
+    }
 
-            if (status[neighborNode] == 0) {
-                double randProb = (double)rand() / RAND_MAX;
-                if (randProb < probability) {
-                    status[neighborNode] = 1;
-                    totalInfluenced++;
+    int step = 0;
+    while (!isEmpty(frontier)) {
+        // Every vertex currently queued was activated at this step
+        int frontierSize = frontier->size;
+        if (trace) {
+            trace->frontierSizes[trace->numSteps++] = frontierSize;
+        }
+        if (maxSteps > 0 && step == maxSteps) {
+            break;
+        }
+        step++;
+
+        // Each newly activated vertex gets one chance to influence each inactive neighbor
+        for (int i = 0; i < frontierSize; i++) {
+            int currentNode = dequeue(frontier);
+            Node* neighbor = graph->adjLists[currentNode];
+
+            while (neighbor) {
+                int neighborNode = neighbor->vertex;
+
+                if (status[neighborNode] == 0) {
+                    double randProb = (double)rand() / RAND_MAX;
+                    if (randProb < probability) {
+                        status[neighborNode] = 1;
+                        enqueue(frontier, neighborNode);
+                        emitCascadeEvent(trace, callback, userData, neighborNode, currentNode, step);
+                    }
                 }
+                neighbor = neighbor->next;
             }
-            neighbor = neighbor->next;
         }
     }
 
+    // The queue never wraps, so rear + 1 is the number of vertices ever activated
+    int totalInfluenced = frontier->rear + 1;
+
     free(status);
+    freeQueue(frontier);
     return totalInfluenced;
 }
 
+// Open a log for appending. A new (empty) file gets the header; an existing file must carry a
+// header with the same layout, so events of different sizes never end up in one log
+CascadeLog* openCascadeLog(const char* path) {
+    FILE* file = fopen(path, "a+b");
+    if (!file) {
+        printf("Failed to open cascade log %s.\n", path);
+        return NULL;
+    }
+
+    CascadeLogHeader header;
+    bool ok;
+    if (fseek(file, 0, SEEK_END) == 0 && ftell(file) == 0) {
+        header.magic = CASCADE_LOG_MAGIC;
+        header.version = CASCADE_LOG_VERSION;
+        header.eventSize = sizeof(CascadeEvent);
+        header.reserved = 0;
+        ok = fwrite(&header, sizeof(header), 1, file) == 1 && fflush(file) == 0;
+    }
+    else {
+        ok = fseek(file, 0, SEEK_SET) == 0 && fread(&header, sizeof(header), 1, file) == 1
+            && header.magic == CASCADE_LOG_MAGIC && header.version == CASCADE_LOG_VERSION
+            && header.eventSize == sizeof(CascadeEvent);
+    }
+    if (!ok) {
+        printf("Cascade log %s has an invalid header or could not be written.\n", path);
+        fclose(file);
+        return NULL;
+    }
+
+    CascadeLog* log = malloc(sizeof(CascadeLog));
+    if (!log) {
+        printf("Memory allocation failed for cascade log.\n");
+        fclose(file);
+        return NULL;
+    }
+    log->file = file;
+    log->eventsWritten = 0;
+    log->writeFailures = 0;
+    return log;
+}
+
+// Append the raw event so long runs can be analysed offline. Failures are counted (and reported
+// once) instead of silently truncating the log
+void appendCascadeEventToLog(const CascadeEvent* event, void* log) {
+    CascadeLog* cascadeLog = (CascadeLog*)log;
+    if (fwrite(event, sizeof(CascadeEvent), 1, cascadeLog->file) == 1) {
+        cascadeLog->eventsWritten++;
+    }
+    else {
+        if (cascadeLog->writeFailures == 0) {
+            printf("Failed to append to cascade log; further events may be lost.\n");
+        }
+        cascadeLog->writeFailures++;
+    }
+}
+
+bool closeCascadeLog(CascadeLog* log) {
+    if (log == NULL) {
+        return false;
+    }
+
+    // Buffered events are only known to be written once the file is flushed and closed
+    bool ok = log->writeFailures == 0;
+    if (fclose(log->file) != 0) {
+        printf("Failed to close cascade log.\n");
+        ok = false;
+    }
+    free(log);
+    return ok;
+}
+
+void freeCascadeTrace(CascadeTrace* trace) {
+    if (trace) {
+        free(trace->events);
+        free(trace->frontierSizes);
+        free(trace);
+    }
+}
+
+
+// SplitMix64 finalizer: turns nearby inputs (seed, world index) into unrelated 64-bit states
+static uint64_t splitMix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// xorshift64*: period 2^64 - 1, so per-world streams do not overlap in practice
+static uint64_t nextRandom64(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+LiveEdgeWorlds* sampleLiveEdgeWorlds(Graph* graph, int numWorlds, unsigned int seed) {
+    if (numWorlds < 1) {
+        printf("Number of live-edge worlds must be positive.\n");
+        return NULL;
+    }
+    // Edges are numbered by the graph's compressed edge arrays
+    if (!ensureEdgeArrays(graph)) {
+        return NULL;
+    }
+
+    LiveEdgeWorlds* worlds = malloc(sizeof(LiveEdgeWorlds));
+    if (!worlds) {
+        printf("Memory allocation failed for live-edge worlds.\n");
+        return NULL;
+    }
+
+    int numEdges = graph->edgeOffsets[graph->numVertices];
+    worlds->numVertices = graph->numVertices;
+    worlds->numWorlds = numWorlds;
+    worlds->numEdges = numEdges;
+    worlds->graphVersion = graph->structureVersion;
+    worlds->edgeDraws = malloc(((size_t)numWorlds * numEdges + 1) * sizeof(uint16_t));
+    if (!worlds->edgeDraws) {
+        printf("Memory allocation failed for live-edge draws.\n");
+        free(worlds);
+        return NULL;
+    }
+
+    // Each world has its own generator, so the result does not depend on the thread count
+#pragma omp parallel for schedule(static)
+    for (int r = 0; r < numWorlds; r++) {
+        uint16_t* draws = worlds->edgeDraws + (size_t)r * numEdges;
+        uint64_t state = splitMix64(((uint64_t)seed << 32) ^ (uint64_t)r);
+        if (state == 0) {
+            state = 1;  // xorshift must not start at zero
+        }
+
+        // Two draws from the high half of each output; the low bits of xorshift64* are weaker
+        for (int e = 0; e < numEdges; e += 2) {
+            uint64_t x = nextRandom64(&state);
+            draws[e] = (uint16_t)(x >> 48);
+            if (e + 1 < numEdges) {
+                draws[e + 1] = (uint16_t)(x >> 32);
+            }
+        }
+    }
+
+    return worlds;
+}
+
+// Average spread over the cached worlds: in each world a vertex is influenced if it is reachable
+// from an unblocked seed through edges live at this probability without passing through a blocked vertex
+double evaluateSpreadOverWorlds(Graph* graph, LiveEdgeWorlds* worlds, double probability, int* seeds, int numSeeds,
+    int* blocked, int numBlocked) {
+    // Any addEdge/removeEdge since sampling changes the version, even if the edge arrays were rebuilt
+    // with the same number of edges
+    if (worlds == NULL || worlds->numVertices != graph->numVertices || graph->edgeOffsets == NULL
+        || worlds->graphVersion != graph->structureVersion
+        || graph->edgeOffsets[graph->numVertices] != worlds->numEdges) {
+        printf("Live-edge worlds do not match the graph.\n");
+        return -1.0;
+    }
+
+    // A draw in [0, 65536) is live when it is below the threshold
+    uint32_t threshold = probability >= 1.0 ? 65536u
+        : probability <= 0.0 ? 0u : (uint32_t)(probability * 65536.0);
+
+    // visited[v] holds the last world in which v was reached, so it never needs clearing
+    int* visited = malloc(graph->numVertices * sizeof(int));
+    int* isBlocked = calloc(graph->numVertices, sizeof(int));
+    Queue* q = createQueue(graph->numVertices);
+    if (!visited || !isBlocked || !q) {
+        printf("Memory allocation failed in evaluateSpreadOverWorlds.\n");
+        free(visited);
+        free(isBlocked);
+        freeQueue(q);
+        return -1.0;
+    }
+
+    for (int i = 0; i < graph->numVertices; i++) {
+        visited[i] = -1;
+    }
+    for (int i = 0; i < numBlocked; i++) {
+        isBlocked[blocked[i]] = 1;
+    }
+
+    const int* offsets = graph->edgeOffsets;
+    const int* neighbors = graph->neighbors;
+    long long totalReached = 0;
+    for (int r = 0; r < worlds->numWorlds; r++) {
+        const uint16_t* draws = worlds->edgeDraws + (size_t)r * worlds->numEdges;
+        q->front = 0;
+        q->rear = -1;
+        q->size = 0;
+
+        for (int i = 0; i < numSeeds; i++) {
+            int seed = seeds[i];
+            if (!isBlocked[seed] && visited[seed] != r) {
+                visited[seed] = r;
+                enqueue(q, seed);
+            }
+        }
+
+        while (!isEmpty(q)) {
+            int v = dequeue(q);
+            for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+                int w = neighbors[e];
+                if (draws[e] < threshold && visited[w] != r && !isBlocked[w]) {
+                    visited[w] = r;
+                    enqueue(q, w);
+                }
+            }
+        }
+
+        // The queue never wraps, so rear + 1 is the number of vertices reached in this world
+        totalReached += q->rear + 1;
+    }
+
+    free(visited);
+    free(isBlocked);
+    freeQueue(q);
+    return (double)totalReached / worlds->numWorlds;
+}
+
+void freeLiveEdgeWorlds(LiveEdgeWorlds* worlds) {
+    if (worlds) {
+        free(worlds->edgeDraws);
+        free(worlds);
+    }
+}
+
+
+// Build edgeOffsets and neighbors from the adjacency lists, without weights
+static bool buildEdgeStructure(Graph* graph) {
+    releaseEdgeArrays(graph);
+
+    graph->edgeOffsets = malloc((graph->numVertices + 1) * sizeof(int));
+    if (!graph->edgeOffsets) {
+        printf("Memory allocation failed for edge offsets.\n");
+        return false;
+    }
+
+    int numEdges = 0;
+    for (int v = 0; v < graph->numVertices; v++) {
+        graph->edgeOffsets[v] = numEdges;
+        for (Node* adj = graph->adjLists[v]; adj; adj = adj->next) {
+            numEdges++;
+        }
+    }
+    graph->edgeOffsets[graph->numVertices] = numEdges;
+
+    // Allocate at least one entry so an edgeless graph still has a valid view
+    graph->neighbors = malloc((numEdges > 0 ? numEdges : 1) * sizeof(int));
+    if (!graph->neighbors) {
+        printf("Memory allocation failed for edge arrays.\n");
+        releaseEdgeArrays(graph);
+        return false;
+    }
+
+    for (int v = 0; v < graph->numVertices; v++) {
+        int e = graph->edgeOffsets[v];
+        for (Node* adj = graph->adjLists[v]; adj; adj = adj->next, e++) {
+            graph->neighbors[e] = adj->vertex;
+        }
+    }
+
+    return true;
+}
+
+// Allocate the weight array if needed and set every weight to defaultWeight
+static bool allocateEdgeWeights(Graph* graph, float defaultWeight) {
+    int numEdges = graph->edgeOffsets[graph->numVertices];
+    if (graph->edgeWeights == NULL) {
+        graph->edgeWeights = malloc((numEdges > 0 ? numEdges : 1) * sizeof(float));
+        if (!graph->edgeWeights) {
+            printf("Memory allocation failed for edge weights.\n");
+            return false;
+        }
+    }
+
+    for (int e = 0; e < numEdges; e++) {
+        graph->edgeWeights[e] = defaultWeight;
+    }
+    return true;
+}
+
+bool buildEdgeArrays(Graph* graph, float defaultWeight) {
+    return buildEdgeStructure(graph) && allocateEdgeWeights(graph, defaultWeight);
+}
+
+bool ensureEdgeArrays(Graph* graph) {
+    return graph->edgeOffsets != NULL || buildEdgeStructure(graph);
+}
+
+bool setEdgeWeight(Graph* graph, int src, int dest, float weight) {
+    if (graph->edgeWeights == NULL) {
+        printf("Edge weights have not been built (or were discarded by addEdge/removeEdge).\n");
+        return false;
+    }
+
+    for (int e = graph->edgeOffsets[src]; e < graph->edgeOffsets[src + 1]; e++) {
+        if (graph->neighbors[e] == dest) {
+            graph->edgeWeights[e] = weight;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Weighted Cascade: each edge into v carries 1 / indegree(v), so the weights into every vertex sum to 1
+void assignWeightedCascadeWeights(Graph* graph) {
+    if (!ensureEdgeArrays(graph) || !allocateEdgeWeights(graph, 0.0f)) {
+        return;
+    }
+
+    int numEdges = graph->edgeOffsets[graph->numVertices];
+    int* inDegree = calloc(graph->numVertices, sizeof(int));
+    if (!inDegree) {
+        printf("Memory allocation failed in assignWeightedCascadeWeights.\n");
+        return;
+    }
+
+    for (int e = 0; e < numEdges; e++) {
+        inDegree[graph->neighbors[e]]++;
+    }
+    // Every edge destination has indegree >= 1, so the division is safe
+    for (int e = 0; e < numEdges; e++) {
+        graph->edgeWeights[e] = 1.0f / (float)inDegree[graph->neighbors[e]];
+    }
+
+    free(inDegree);
+}
+
+// Counter-based draw for (run, index): every edge gets its own value without any state carried
+// between iterations, so the loops that use it can be vectorized (lowbias32 mixer)
+static uint32_t hashDraw(uint32_t runKey, uint32_t index) {
+    uint32_t x = index * 0x9E3779B9u ^ runKey;
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// Uniform float in [0, 1) from the top 24 bits of a draw
+static float drawToUniform(uint32_t draw) {
+    return (float)(int32_t)(draw >> 8) * (1.0f / 16777216.0f);
+}
+
+// Key each run from rand() so srand() still controls the simulation
+static uint32_t runKeyFromRand(void) {
+    return ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+}
+
+// Largest out-degree, which sizes the per-vertex scratch buffers
+static int maxEdgeSpan(const Graph* graph) {
+    int maxSpan = 0;
+    for (int v = 0; v < graph->numVertices; v++) {
+        int span = graph->edgeOffsets[v + 1] - graph->edgeOffsets[v];
+        maxSpan = span > maxSpan ? span : maxSpan;
+    }
+    return maxSpan;
+}
+
+// Independent Cascade Model where edge u -> v succeeds with probability edgeWeights[e].
+// Each vertex's edge span is processed in two passes: a branch-free mask loop with no
+// loop-carried state (vectorizable), then a compaction that appends the newly activated neighbors
+int propagateMisinformationWeighted(Graph* graph, int* influenced, int numInfluenced) {
+    if (graph->edgeOffsets == NULL || graph->edgeWeights == NULL) {
+        printf("Edge weights have not been built (or were discarded by addEdge/removeEdge).\n");
+        return -1;
+    }
+
+    unsigned char* status = calloc(graph->numVertices, sizeof(unsigned char));
+    int* order = malloc((graph->numVertices + 1) * sizeof(int));  // Activation order; +1 for the speculative write
+    unsigned char* fires = malloc(maxEdgeSpan(graph) + 1);
+    if (!status || !order || !fires) {
+        printf("Memory allocation failed in propagateMisinformationWeighted.\n");
+        free(status);
+        free(order);
+        free(fires);
+        return -1;
+    }
+
+    int count = 0;
+    for (int i = 0; i < numInfluenced; i++) {
+        int seed = influenced[i];
+        if (!status[seed]) {
+            status[seed] = 1;
+            order[count++] = seed;
+        }
+    }
+
+    const int* offsets = graph->edgeOffsets;
+    const int* neighbors = graph->neighbors;
+    const float* weights = graph->edgeWeights;
+    uint32_t runKey = runKeyFromRand();
+
+    // order doubles as the BFS queue: every activated vertex is processed exactly once, so each
+    // edge is tried at most once and its draw can be keyed by the edge index alone
+    for (int head = 0; head < count; head++) {
+        int v = order[head];
+        int begin = offsets[v];
+        int span = offsets[v + 1] - begin;
+
+        for (int i = 0; i < span; i++) {
+            fires[i] = drawToUniform(hashDraw(runKey, (uint32_t)(begin + i))) < weights[begin + i];
+        }
+
+        for (int i = 0; i < span; i++) {
+            int w = neighbors[begin + i];
+            int activate = fires[i] & (status[w] == 0);
+            status[w] |= (unsigned char)activate;
+            order[count] = w;
+            count += activate;
+        }
+    }
+
+    free(status);
+    free(order);
+    free(fires);
+    return count;
+}
+
+// Linear Threshold model: each vertex draws a threshold in [0, 1) and becomes influenced once
+// the summed weights of its influenced in-neighbors reach it
+int propagateLinearThreshold(Graph* graph, int* influenced, int numInfluenced) {
+    if (graph->edgeOffsets == NULL || graph->edgeWeights == NULL) {
+        printf("Edge weights have not been built (or were discarded by addEdge/removeEdge).\n");
+        return -1;
+    }
+
+    unsigned char* status = calloc(graph->numVertices, sizeof(unsigned char));
+    float* threshold = malloc(graph->numVertices * sizeof(float));
+    float* incoming = calloc(graph->numVertices, sizeof(float));
+    int* order = malloc((graph->numVertices + 1) * sizeof(int));  // Activation order; +1 for the speculative write
+    unsigned char* fires = malloc(maxEdgeSpan(graph) + 1);
+    if (!status || !threshold || !incoming || !order || !fires) {
+        printf("Memory allocation failed in propagateLinearThreshold.\n");
+        free(status);
+        free(threshold);
+        free(incoming);
+        free(order);
+        free(fires);
+        return -1;
+    }
+
+    uint32_t runKey = runKeyFromRand();
+    for (int i = 0; i < graph->numVertices; i++) {
+        threshold[i] = drawToUniform(hashDraw(runKey, (uint32_t)i));
+    }
+
+    int count = 0;
+    for (int i = 0; i < numInfluenced; i++) {
+        int seed = influenced[i];
+        if (!status[seed]) {
+            status[seed] = 1;
+            order[count++] = seed;
+        }
+    }
+
+    const int* offsets = graph->edgeOffsets;
+    const int* neighbors = graph->neighbors;
+    const float* weights = graph->edgeWeights;
+
+    // Each influenced vertex pushes its weight to its neighbors once. Weights are non-negative, so
+    // checking thresholds after the whole span is pushed activates the same vertices as checking
+    // after every edge, and matches the synchronous step-by-step formulation
+    for (int head = 0; head < count; head++) {
+        int v = order[head];
+        int begin = offsets[v];
+        int span = offsets[v + 1] - begin;
+
+        // Scatter-add; kept scalar because a span may name the same neighbor twice
+        for (int i = 0; i < span; i++) {
+            incoming[neighbors[begin + i]] += weights[begin + i];
+        }
+
+        // Branch-free mask over the span (gathers only, vectorizable)
+        for (int i = 0; i < span; i++) {
+            int w = neighbors[begin + i];
+            fires[i] = incoming[w] >= threshold[w];
+        }
+
+        for (int i = 0; i < span; i++) {
+            int w = neighbors[begin + i];
+            int activate = fires[i] & (status[w] == 0);
+            status[w] |= (unsigned char)activate;
+            order[count] = w;
+            count += activate;
+        }
+    }
+
+    free(status);
+    free(threshold);
+    free(incoming);
+    free(order);
+    free(fires);
+    return count;
+}
+
 
 void printGraph(Graph* graph) {
     if (graph == NULL) {
@@ -403,6 +1028,9 @@ Graph* generateWattsStrogatzGraph(int n, int k, double beta) {
 /* Function to remove an edge within the adjacency list */
 
 void removeEdge(Graph* graph, int src, int dest) {
+    releaseEdgeArrays(graph);
+    graph->structureVersion++;
+
     Node* current = graph->adjLists[src];
     Node* prev = NULL;
 
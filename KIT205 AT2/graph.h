@@ -3,6 +3,8 @@
 #define GRAPH_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 
 // Represents an adjacency list node
 typedef struct Node {
@@ -10,10 +12,71 @@ typedef struct Node {
     struct Node* next;
 } Node;
 
-// Represents the graph structure with an adjacency list for each vertex
+// Records one activation during a time-stepped cascade
+typedef struct CascadeEvent {
+    int node;    // Newly influenced vertex
+    int parent;  // Vertex whose edge carried the misinformation (-1 for seeds)
+    int step;    // Step at which the vertex was activated (0 for seeds)
+} CascadeEvent;
+
+// Called once per activation, in activation order
+typedef void (*CascadeCallback)(const CascadeEvent* event, void* userData);
+
+// Preallocated trace of a cascade; each vertex activates at most once so capacity is numVertices
+typedef struct CascadeTrace {
+    CascadeEvent* events;  // Activation events in the order they happened
+    int count;             // Number of recorded events
+    int capacity;          // Allocated events (numVertices)
+    int* frontierSizes;    // frontierSizes[t] = number of vertices activated at step t
+    int numSteps;          // Number of valid entries in frontierSizes
+} CascadeTrace;
+
+// First bytes of a binary cascade log, written once when the log is created. The header is
+// followed by a flat sequence of CascadeEvent records, each eventSize bytes long
+#define CASCADE_LOG_MAGIC 0x43534143u  // "CASC"
+#define CASCADE_LOG_VERSION 1u
+typedef struct CascadeLogHeader {
+    uint32_t magic;      // CASCADE_LOG_MAGIC
+    uint32_t version;    // CASCADE_LOG_VERSION
+    uint32_t eventSize;  // sizeof(CascadeEvent) of the writer
+    uint32_t reserved;   // Always 0
+} CascadeLogHeader;
+
+// Append-only cascade log; pass it as userData to appendCascadeEventToLog
+typedef struct CascadeLog {
+    FILE* file;
+    long long eventsWritten;  // Events appended through this handle
+    long long writeFailures;  // Events that could not be written (e.g. disk full)
+} CascadeLog;
+
+// Pre-sampled live-edge worlds for evaluating many scenarios against the same coin flips.
+// Each world holds one quantized uniform draw per directed edge, in the order of the graph's edge
+// arrays. An edge is live at probability p when its draw is below p * 65536, so every probability is
+// evaluated against the same draws. addEdge and removeEdge invalidate the worlds
+typedef struct LiveEdgeWorlds {
+    int numVertices;
+    int numWorlds;         // Number of sampled worlds (R)
+    int numEdges;          // Number of directed edges when the worlds were sampled
+    unsigned int graphVersion;  // Graph structureVersion when the worlds were sampled
+    uint16_t* edgeDraws;   // numWorlds * numEdges draws, one world after another
+} LiveEdgeWorlds;
+
+// Represents the graph structure with an adjacency list for each vertex.
+// buildEdgeArrays adds a compressed view of the lists: the neighbors of v are
+// neighbors[edgeOffsets[v]] .. neighbors[edgeOffsets[v + 1] - 1], in adjacency-list order,
+// with per-edge weights in the parallel edgeWeights array. The view costs 8 bytes per directed
+// edge (4 for the neighbor, 4 for the weight) plus 4 bytes per vertex: the weights alone are
+// 4 bytes per edge, and the neighbor copy is what lets the weighted models, the live-edge worlds
+// and the shared-memory betweenness driver scan contiguous arrays instead of the linked lists.
+// addEdge and removeEdge free the view, so every weight set with setEdgeWeight or
+// assignWeightedCascadeWeights is lost and must be assigned again after changing the graph.
 typedef struct Graph {
     int numVertices;
     Node** adjLists;
+    int* edgeOffsets;    // numVertices + 1 entries, NULL until built and again after addEdge/removeEdge
+    int* neighbors;      // Destination of each directed edge
+    float* edgeWeights;  // Propagation probability / influence weight of each directed edge, NULL until assigned
+    unsigned int structureVersion;  // Incremented by every addEdge/removeEdge
 } Graph;
 
 // Graph creation and manipulation
@@ -21,13 +84,42 @@ Graph* createGraph(int vertices);  // Initialize a graph with a specified number
 void addEdge(Graph* graph, int src, int dest);  // Add an undirected edge between src and dest
 void removeEdge(Graph* graph, int src, int dest);  // Remove an undirected edge between src and dest
 
+// Per-edge weights (stored alongside the compressed neighbor array)
+bool buildEdgeArrays(Graph* graph, float defaultWeight);  // Build the compressed view with every edge weighted defaultWeight
+bool ensureEdgeArrays(Graph* graph);  // Build the compressed view without weights, only if it does not exist yet
+bool setEdgeWeight(Graph* graph, int src, int dest, float weight);  // Set the weight of the directed edge src -> dest
+void assignWeightedCascadeWeights(Graph* graph);  // Weight each edge u -> v with 1 / indegree(v)
+
 // Centrality calculations
 int* calculateDegreeCentrality(Graph* graph);  // Calculate the degree centrality of each vertex
 double* calculateBetweennessCentrality(Graph* graph);  // Calculate betweenness centrality for each vertex
+bool accumulateBetweennessFromSource(Graph* graph, int s, double* betweenness);  // Add one source's dependencies (unnormalized)
+bool accumulateBetweennessFromEdgeArrays(int numVertices, const int* edgeOffsets, const int* neighbors,
+    int s, double* betweenness);  // Same, straight from a compressed view (e.g. one in shared memory)
 
 // Critical node selection and misinformation spread simulation
 int* selectCriticalNodes(Graph* graph, int k);  // Select top-k critical nodes based on centrality
-int propagateMisinformation(Graph* graph, int* influenced, int numInfluenced, double probability);  // Simulate misinformation spread
+int propagateMisinformation(Graph* graph, int* influenced, int numInfluenced, double probability);  // One-step spread from the seeds only
+
+// Time-stepped cascade tracing
+// propagateMisinformation is this function with maxSteps = 1; maxSteps <= 0 runs the cascade to completion
+CascadeTrace* createCascadeTrace(Graph* graph);  // Allocate a trace sized for the graph
+int propagateMisinformationTraced(Graph* graph, int* influenced, int numInfluenced, double probability,
+    int maxSteps, CascadeTrace* trace, CascadeCallback callback, void* userData);  // Run the cascade, recording each activation
+CascadeLog* openCascadeLog(const char* path);  // Open (or create, writing the header) a binary log for appending
+void appendCascadeEventToLog(const CascadeEvent* event, void* log);  // Callback that appends one event to a CascadeLog
+bool closeCascadeLog(CascadeLog* log);  // Close the log; false if any write failed
+void freeCascadeTrace(CascadeTrace* trace);  // Free the trace buffers
+
+// Live-edge world cache (common random numbers for what-if comparisons)
+LiveEdgeWorlds* sampleLiveEdgeWorlds(Graph* graph, int numWorlds, unsigned int seed);  // Sample R worlds once
+double evaluateSpreadOverWorlds(Graph* graph, LiveEdgeWorlds* worlds, double probability, int* seeds, int numSeeds,
+    int* blocked, int numBlocked);  // Average number of vertices reached from seeds with blocked vertices removed
+void freeLiveEdgeWorlds(LiveEdgeWorlds* worlds);  // Free the world cache
+
+// Weighted propagation models (return -1 if no weights were assigned, or they were discarded by addEdge/removeEdge)
+int propagateMisinformationWeighted(Graph* graph, int* influenced, int numInfluenced);  // ICM using per-edge probabilities
+int propagateLinearThreshold(Graph* graph, int* influenced, int numInfluenced);  // Linear Threshold model using per-edge weights
 
 // Utility functions for debugging and memory management
 void printGraph(Graph* graph);  // Print the adjacency list of each vertex
@@ -1,6 +1,18 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L  // mkdtemp
+#endif
+
 #include "graph.h"
+#include "betweenness_mp.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <unistd.h>
+#endif
 
 // Helper function to free the graph and all its nodes
 void freeGraph(Graph* graph) {
@@ -13,6 +25,9 @@ void freeGraph(Graph* graph) {
         }
     }
     free(graph->adjLists);  // Free the adjacency lists array
+    free(graph->edgeOffsets);  // Free the compressed edge view (NULL if never built)
+    free(graph->neighbors);
+    free(graph->edgeWeights);
     free(graph);  // Finally, free the graph structure itself
 }
 
@@ -79,6 +94,101 @@ void test_calculateBetweennessCentrality() {
     freeGraph(graph);  // Properly free the graph
 }
 
+#ifndef _WIN32
+// Remove the checkpoint files written by the multi-process test, then the directory itself
+static void removeCheckpointDir(const char* path) {
+    DIR* dir = opendir(path);
+    if (dir) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (entry->d_name[0] != '.') {
+                char filePath[4096];
+                snprintf(filePath, sizeof(filePath), "%s/%s", path, entry->d_name);
+                remove(filePath);
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(path);
+}
+
+void test_calculateBetweennessCentralityMultiProcess() {
+    printf("Testing calculateBetweennessCentralityMultiProcess()...\n");
+    Graph* graph = createGraph(5);
+    addEdge(graph, 0, 1);
+    addEdge(graph, 0, 4);
+    addEdge(graph, 1, 2);
+    addEdge(graph, 1, 3);
+    addEdge(graph, 2, 3);
+    addEdge(graph, 3, 4);
+
+    char checkpointDir[] = "/tmp/kit205_betweenness_XXXXXX";
+    if (mkdtemp(checkpointDir) == NULL) {
+        printf("calculateBetweennessCentralityMultiProcess() failed: could not create checkpoint directory.\n");
+        freeGraph(graph);
+        return;
+    }
+
+    double* expected = calculateBetweennessCentrality(graph);
+    double* parallel = calculateBetweennessCentralityMultiProcess(graph, 2, 2, checkpointDir);
+
+    // Finished ranges are merged into one file, and the per-range files are gone
+    int rangeFilesLeft = 0;
+    DIR* dir = opendir(checkpointDir);
+    if (dir) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL) {
+            rangeFilesLeft += strncmp(entry->d_name, "range_", 6) == 0;
+        }
+        closedir(dir);
+    }
+
+    // Resuming a finished run reuses the merged scores; losing them (as if the driver died before
+    // its first merge) means every range is recomputed
+    double* reused = calculateBetweennessCentralityMultiProcess(graph, 2, 2, checkpointDir);
+    char mergedCheckpoint[4096];
+    snprintf(mergedCheckpoint, sizeof(mergedCheckpoint), "%s/merged.bin", checkpointDir);
+    int removed = remove(mergedCheckpoint) == 0;
+    double* resumed = calculateBetweennessCentralityMultiProcess(graph, 2, 2, checkpointDir);
+
+    int passed = rangeFilesLeft == 0 && removed && parallel != NULL && reused != NULL && resumed != NULL;
+    for (int i = 0; passed && i < graph->numVertices; i++) {
+        if (fabs(parallel[i] - expected[i]) > 1e-9 || fabs(reused[i] - expected[i]) > 1e-9 ||
+            fabs(resumed[i] - expected[i]) > 1e-9) {
+            passed = 0;
+        }
+    }
+
+    // Checkpoints written for another chunk size or another graph are rejected, not merged
+    Graph* otherGraph = createGraph(5);
+    addEdge(otherGraph, 0, 1);
+    addEdge(otherGraph, 1, 2);
+    addEdge(otherGraph, 2, 3);
+    addEdge(otherGraph, 3, 4);
+    double* otherChunkSize = calculateBetweennessCentralityMultiProcess(graph, 2, 3, checkpointDir);
+    double* otherGraphResult = calculateBetweennessCentralityMultiProcess(otherGraph, 2, 2, checkpointDir);
+    if (otherChunkSize != NULL || otherGraphResult != NULL) {
+        passed = 0;
+    }
+    free(otherChunkSize);
+    free(otherGraphResult);
+    freeGraph(otherGraph);
+
+    if (passed) {
+        printf("calculateBetweennessCentralityMultiProcess() passed.\n");
+    }
+    else {
+        printf("calculateBetweennessCentralityMultiProcess() failed.\n");
+    }
+    free(expected);
+    free(parallel);
+    free(reused);
+    free(resumed);
+    removeCheckpointDir(checkpointDir);
+    freeGraph(graph);
+}
+#endif
+
 void test_selectCriticalNodes() {
     printf("Testing selectCriticalNodes()...\n");
     Graph* graph = createGraph(5);
@@ -96,6 +206,176 @@ void test_selectCriticalNodes() {
     freeGraph(graph);  // Properly free the graph
 }
 
+// Counts activations delivered through the callback interface
+void countCascadeEvent(const CascadeEvent* event, void* userData) {
+    (void)event;
+    (*(int*)userData)++;
+}
+
+void test_propagateMisinformationTraced() {
+    printf("Testing propagateMisinformationTraced()...\n");
+    Graph* graph = createGraph(5);
+    addEdge(graph, 0, 1);
+    addEdge(graph, 1, 2);
+    addEdge(graph, 2, 3);
+    addEdge(graph, 3, 4);
+
+    // A probability above 1 always fires (rand() / RAND_MAX can equal 1), so the cascade walks
+    // the path one vertex per step
+    CascadeTrace* trace = createCascadeTrace(graph);
+    int seeds[] = { 0 };
+    int callbackCount = 0;
+    int total = propagateMisinformationTraced(graph, seeds, 1, 2.0, 0, trace, countCascadeEvent, &callbackCount);
+
+    int passed = total == 5 && trace->count == 5 && callbackCount == 5 && trace->numSteps == 5;
+    for (int i = 0; passed && i < trace->count; i++) {
+        CascadeEvent* event = &trace->events[i];
+        if (event->node != i || event->step != i || event->parent != i - 1 || trace->frontierSizes[i] != 1) {
+            passed = 0;
+        }
+    }
+
+    // Limited to one step it matches propagateMisinformation: the seed and its neighbor
+    int oneStep = propagateMisinformationTraced(graph, seeds, 1, 2.0, 1, trace, NULL, NULL);
+    if (oneStep != 2 || trace->numSteps != 2 || propagateMisinformation(graph, seeds, 1, 2.0) != 2) {
+        passed = 0;
+    }
+
+    // A trace sized for a smaller graph is rejected
+    Graph* smallGraph = createGraph(2);
+    CascadeTrace* smallTrace = createCascadeTrace(smallGraph);
+    if (propagateMisinformationTraced(graph, seeds, 1, 2.0, 0, smallTrace, NULL, NULL) != -1) {
+        passed = 0;
+    }
+    freeCascadeTrace(smallTrace);
+    freeGraph(smallGraph);
+
+    // The binary log starts with one header and keeps it when reopened for appending
+    const char* logPath = "cascade_test.log";
+    remove(logPath);
+    CascadeLog* log = openCascadeLog(logPath);
+    if (log == NULL) {
+        passed = 0;
+    }
+    else {
+        propagateMisinformationTraced(graph, seeds, 1, 2.0, 0, NULL, appendCascadeEventToLog, log);
+        if (log->eventsWritten != 5 || !closeCascadeLog(log)) {
+            passed = 0;
+        }
+        log = openCascadeLog(logPath);
+        if (log == NULL || !closeCascadeLog(log)) {
+            passed = 0;
+        }
+
+        FILE* logFile = fopen(logPath, "rb");
+        CascadeLogHeader header;
+        if (logFile == NULL || fread(&header, sizeof(header), 1, logFile) != 1
+            || header.magic != CASCADE_LOG_MAGIC || header.eventSize != sizeof(CascadeEvent)
+            || fseek(logFile, 0, SEEK_END) != 0
+            || ftell(logFile) != (long)(sizeof(CascadeLogHeader) + 5 * sizeof(CascadeEvent))) {
+            passed = 0;
+        }
+        if (logFile) {
+            fclose(logFile);
+        }
+    }
+    remove(logPath);
+
+    if (passed) {
+        printf("propagateMisinformationTraced() passed.\n");
+    }
+    else {
+        printf("propagateMisinformationTraced() failed.\n");
+    }
+    freeCascadeTrace(trace);
+    freeGraph(graph);
+}
+
+void test_evaluateSpreadOverWorlds() {
+    printf("Testing evaluateSpreadOverWorlds()...\n");
+    Graph* graph = createGraph(5);
+    addEdge(graph, 0, 1);
+    addEdge(graph, 1, 2);
+    addEdge(graph, 2, 3);
+    addEdge(graph, 3, 4);
+
+    int seeds[] = { 0 };
+    int blocked[] = { 2 };
+
+    // Every edge is live at probability 1 and none are at probability 0
+    LiveEdgeWorlds* worlds = sampleLiveEdgeWorlds(graph, 16, 42);
+    double fullSpread = evaluateSpreadOverWorlds(graph, worlds, 1.0, seeds, 1, NULL, 0);
+    double blockedSpread = evaluateSpreadOverWorlds(graph, worlds, 1.0, seeds, 1, blocked, 1);
+    double seedOnly = evaluateSpreadOverWorlds(graph, worlds, 0.0, seeds, 1, NULL, 0);
+
+    // The draws are shared across probabilities, so spread cannot shrink as the probability grows
+    double lowSpread = evaluateSpreadOverWorlds(graph, worlds, 0.3, seeds, 1, NULL, 0);
+    double highSpread = evaluateSpreadOverWorlds(graph, worlds, 0.7, seeds, 1, NULL, 0);
+
+    // The same seed must reproduce the same worlds
+    LiveEdgeWorlds* again = sampleLiveEdgeWorlds(graph, 16, 42);
+    double againSpread = evaluateSpreadOverWorlds(graph, again, 0.3, seeds, 1, NULL, 0);
+
+    // Worlds are invalid once the graph changes, even if a rewire keeps the edge count and the
+    // edge arrays are rebuilt; a non-positive world count is rejected
+    removeEdge(graph, 1, 2);
+    addEdge(graph, 2, 4);
+    assignWeightedCascadeWeights(graph);
+    double staleSpread = evaluateSpreadOverWorlds(graph, worlds, 1.0, seeds, 1, NULL, 0);
+    LiveEdgeWorlds* noWorlds = sampleLiveEdgeWorlds(graph, -1, 42);
+
+    if (fullSpread == 5.0 && blockedSpread == 2.0 && seedOnly == 1.0 && lowSpread <= highSpread
+        && againSpread == lowSpread && staleSpread == -1.0 && noWorlds == NULL) {
+        printf("evaluateSpreadOverWorlds() passed.\n");
+    }
+    else {
+        printf("evaluateSpreadOverWorlds() failed.\n");
+    }
+    freeLiveEdgeWorlds(worlds);
+    freeLiveEdgeWorlds(again);
+    freeGraph(graph);
+}
+
+void test_weightedPropagation() {
+    printf("Testing weighted propagation models...\n");
+    Graph* graph = createGraph(5);
+    addEdge(graph, 0, 1);
+    addEdge(graph, 1, 2);
+    addEdge(graph, 2, 3);
+    addEdge(graph, 3, 4);
+
+    // Certain edges everywhere except 2 -> 3, which never transmits
+    buildEdgeArrays(graph, 1.0f);
+    setEdgeWeight(graph, 2, 3, 0.0f);
+    int seeds[] = { 0 };
+    int weightedICM = propagateMisinformationWeighted(graph, seeds, 1);
+
+    // On a path the second vertex has indegree 2, so its weight from the seed is 0.5
+    assignWeightedCascadeWeights(graph);
+    int weightedCascadeOk = graph->edgeWeights[graph->edgeOffsets[0]] == 0.5f;
+
+    // With every weight 1 any threshold is reached, so LT influences the whole path
+    buildEdgeArrays(graph, 1.0f);
+    int linearThreshold = propagateLinearThreshold(graph, seeds, 1);
+
+    // Changing the graph discards the weights, so the weighted models refuse to run
+    addEdge(graph, 0, 4);
+    int afterChange = propagateMisinformationWeighted(graph, seeds, 1);
+
+    // Rebuilding only the structure (as the unweighted users do) does not invent weights
+    ensureEdgeArrays(graph);
+    int structureOnly = propagateLinearThreshold(graph, seeds, 1);
+
+    if (weightedICM == 3 && weightedCascadeOk && linearThreshold == 5 && afterChange == -1 &&
+        structureOnly == -1) {
+        printf("Weighted propagation models passed.\n");
+    }
+    else {
+        printf("Weighted propagation models failed.\n");
+    }
+    freeGraph(graph);
+}
+
 /* Testing different graph structures */
 
 // Testing a simple connected graph
@@ -222,7 +502,13 @@ int main() {
     test_addEdge();
     test_calculateDegreeCentrality();
     test_calculateBetweennessCentrality();
+#ifndef _WIN32
+    test_calculateBetweennessCentralityMultiProcess();
+#endif
     test_selectCriticalNodes();
+    test_propagateMisinformationTraced();
+    test_evaluateSpreadOverWorlds();
+    test_weightedPropagation();
 
     // testing the various graph structures
     test_simpleConnectedGraph();